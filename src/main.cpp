@@ -10,10 +10,28 @@
 #include <fstream>
 #include <filesystem>
 #include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
 #include <vector>
+#include <map>
+#include <iterator>
 #include <variant>
 #include <optional>
 #include <algorithm>
+#include <charconv>
+#include <memory>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+
+#include <zlib.h>
+
+#ifdef SIE_WITH_ZSTD
+#include <zstd.h>
+#endif
 
 /**
  * SIE file white space between "tokens
@@ -62,20 +80,124 @@ auto format_and_output_line_to_cout = [](const std::string& sLine) {
     }
 };
 
-using c_Tokens = std::vector<std::string>;
+/**
+ * Arena for token text that does not fit inline in a c_Token.
+ * Text is appended to large chunks that are never moved or freed while the arena lives.
+ * NOTE: Not thread safe. Tokens are created on the parser thread only.
+ * */
+class c_TokenArena {
+public:
+    static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+    char const* store(std::string_view text) {
+        if (text.size() > CHUNK_SIZE) {
+            m_large_texts.push_back(std::make_unique<char[]>(text.size()));
+            std::memcpy(m_large_texts.back().get(),text.data(),text.size());
+            return m_large_texts.back().get();
+        }
+        if (m_chunks.empty() || (m_used + text.size() > CHUNK_SIZE)) {
+            m_chunks.push_back(std::make_unique<char[]>(CHUNK_SIZE));
+            m_used = 0;
+        }
+        char* result = m_chunks.back().get() + m_used;
+        std::memcpy(result,text.data(),text.size());
+        m_used += text.size();
+        return result;
+    }
+
+private:
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+    std::vector<std::unique_ptr<char[]>> m_large_texts; // Texts larger than a chunk
+    std::size_t m_used = 0;
+};
+
+// The shared token arena lives for the whole program run (parsed SIE file entries may live as long)
+c_TokenArena& token_arena() {
+    static c_TokenArena arena{};
+    return arena;
+}
+
+enum class e_TokenKind : std::uint8_t {
+     Bare   // e.g., #TRANS 1920 -6.00
+    ,Quoted // e.g., "Mån.avg. PG" (quotes not part of token text)
+};
+
+/**
+ * Compact SIE token (24 bytes).
+ * Most SIE tokens are short (labels, accounts, dates and amounts) and are stored inline.
+ * Longer text (e.g., quoted #VER and #TRANS texts) is stored in the shared token arena.
+ * A c_Token is trivially copyable, i.e., it moves into a c_SIEFileEntry without any heap allocation.
+ * */
+class c_Token {
+public:
+    static constexpr std::size_t INLINE_CAPACITY = 22;
+
+    c_Token() : m_bytes{}, m_inline_size{0}, m_kind{e_TokenKind::Bare} {}
+
+    c_Token(std::string_view text,e_TokenKind kind = e_TokenKind::Bare) : m_bytes{}, m_inline_size{0}, m_kind{kind} {
+        if (text.size() <= INLINE_CAPACITY) {
+            std::memcpy(m_bytes,text.data(),text.size());
+            m_inline_size = static_cast<std::uint8_t>(text.size());
+        }
+        else {
+            // Spilled: m_bytes holds pointer to arena text followed by its size
+            char const* data = token_arena().store(text);
+            std::uint32_t size = static_cast<std::uint32_t>(text.size());
+            std::memcpy(m_bytes,&data,sizeof(data));
+            std::memcpy(m_bytes + sizeof(data),&size,sizeof(size));
+            m_inline_size = SPILLED;
+        }
+    }
+
+    std::string_view view() const {
+        if (m_inline_size != SPILLED) {
+            return {m_bytes,m_inline_size};
+        }
+        char const* data;
+        std::uint32_t size;
+        std::memcpy(&data,m_bytes,sizeof(data));
+        std::memcpy(&size,m_bytes + sizeof(data),sizeof(size));
+        return {data,size};
+    }
+
+    std::string str() const {return std::string{view()};}
+    std::size_t size() const {return view().size();}
+    bool empty() const {return m_inline_size == 0;}
+    char back() const {return view().back();}
+    e_TokenKind kind() const {return m_kind;}
+    bool is_quoted() const {return m_kind == e_TokenKind::Quoted;}
+
+private:
+    static constexpr std::uint8_t SPILLED = 0xFF;
+
+    alignas(alignof(char const*)) char m_bytes[INLINE_CAPACITY];
+    std::uint8_t m_inline_size; // SPILLED = text in token arena
+    e_TokenKind m_kind;
+};
+
+static_assert(sizeof(c_Token) == 24,"c_Token expected to be 24 bytes");
+
+bool operator==(c_Token const& token,std::string_view text) {return token.view() == text;}
+bool operator!=(c_Token const& token,std::string_view text) {return token.view() != text;}
+
+std::ostream& operator<<(std::ostream& os, c_Token const& token) {
+    return os << token.view();
+}
+
+using c_Tokens = std::vector<c_Token>;
 using c_SubEntries = std::vector<c_Tokens>;
 
 class c_SIEFileEntry {
     friend std::ostream& operator<<(std::ostream& os, c_SIEFileEntry file_entry);
 public:
-    c_SIEFileEntry(const c_Tokens tokens) 
-        :  m_tokens{tokens}, m_sub_entries{} {}
+    c_SIEFileEntry(c_Tokens tokens) 
+        :  m_tokens{std::move(tokens)}, m_sub_entries{} {}
 
     bool has_sub_entries() {return m_sub_entries.size() > 0;}
     c_Tokens const& tokens() const {return m_tokens;}
     c_SubEntries const& sub_entries() const {return m_sub_entries;}
 
-    void add_sub_entry(const c_Tokens sub_entry) {m_sub_entries.push_back(sub_entry);}
+    void add_sub_entry(c_Tokens sub_entry) {m_sub_entries.push_back(std::move(sub_entry));}
 
 private:
     c_Tokens m_tokens;
@@ -111,7 +233,240 @@ std::ostream& operator<<(std::ostream& os, c_SIEFileEntry entry) {
 
 using c_SIEFileEntries = std::vector<c_SIEFileEntry>;
 
-c_SIEFileEntries parse_sie_file(std::ifstream& sie_file) {
+/**
+ * Compressed SIE file input stage.
+ * Archived SIE files may be gzip or zstd compressed. We detect the compression from the
+ * file magic bytes and decompress on a separate thread in large blocks that the tokenizer
+ * then consumes through a std::istream (i.e., no temporary decompressed file on disk).
+ * 
+ * gzip support requires zlib (link with -lz).
+ * zstd support is opt-in (build with -DSIE_WITH_ZSTD and link with -lzstd).
+ * */
+enum class e_SIEFileCompression {
+     None
+    ,GZip
+    ,ZStd
+};
+
+e_SIEFileCompression detect_compression(std::filesystem::path const& file_path) {
+    e_SIEFileCompression result = e_SIEFileCompression::None;
+    std::ifstream file(file_path,std::ios::binary);
+    unsigned char magic[4] = {0,0,0,0};
+    file.read(reinterpret_cast<char*>(magic),sizeof(magic));
+    if ((file.gcount() >= 2) && (magic[0] == 0x1F) && (magic[1] == 0x8B)) {
+        result = e_SIEFileCompression::GZip; // RFC 1952
+    }
+    else if ((file.gcount() == 4) && (magic[0] == 0x28) && (magic[1] == 0xB5) && (magic[2] == 0x2F) && (magic[3] == 0xFD)) {
+        result = e_SIEFileCompression::ZStd; // RFC 8878
+    }
+    return result;
+}
+
+class c_DecompressingStreamBuf : public std::streambuf {
+public:
+    static constexpr std::size_t BLOCK_SIZE = 1 << 20; // 1 MB
+    static constexpr std::size_t MAX_QUEUED_BLOCKS = 4;
+
+    c_DecompressingStreamBuf(std::filesystem::path const& file_path,e_SIEFileCompression compression)
+        :  m_file{file_path,std::ios::binary}
+          ,m_worker{[this,compression]() {decompress(compression);}} {}
+
+    ~c_DecompressingStreamBuf() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_is_cancelled = true;
+        }
+        m_block_consumed.notify_all();
+        m_worker.join();
+    }
+
+protected:
+    int_type underflow() override {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_block_available.wait(lock,[this]() {return !m_blocks.empty() || m_is_done;});
+        if (m_blocks.empty()) {
+            if (!m_sError.empty()) {
+                // Report once and fail the stream (std::istream sets badbit when underflow throws)
+                if (!m_is_error_reported) {
+                    std::cout << "\nERROR: " << m_sError;
+                    m_is_error_reported = true;
+                }
+                throw std::runtime_error(m_sError);
+            }
+            return traits_type::eof();
+        }
+        m_current_block = std::move(m_blocks.front());
+        m_blocks.pop_front();
+        lock.unlock();
+        m_block_consumed.notify_one();
+        setg(m_current_block.data(),m_current_block.data(),m_current_block.data() + m_current_block.size());
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    using c_Block = std::vector<char>;
+
+    std::ifstream m_file;
+    std::mutex m_mutex;
+    std::condition_variable m_block_available;
+    std::condition_variable m_block_consumed;
+    std::deque<c_Block> m_blocks;
+    c_Block m_current_block;
+    bool m_is_done = false;
+    bool m_is_cancelled = false;
+    std::string m_sError;
+    bool m_is_error_reported = false;
+    std::thread m_worker; // Last member: started when all other members are constructed
+
+    // Called on worker thread. Returns false if the reader has gone away
+    bool push_block(c_Block&& block) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_block_consumed.wait(lock,[this]() {return (m_blocks.size() < MAX_QUEUED_BLOCKS) || m_is_cancelled;});
+        if (m_is_cancelled) return false;
+        m_blocks.push_back(std::move(block));
+        lock.unlock();
+        m_block_available.notify_one();
+        return true;
+    }
+
+    // Called on worker thread. Returns number of bytes read into input (0 on end of file)
+    std::size_t read_block(c_Block& input) {
+        m_file.read(input.data(),input.size());
+        return static_cast<std::size_t>(m_file.gcount());
+    }
+
+    void decompress(e_SIEFileCompression compression) {
+        std::string sError;
+        switch (compression) {
+            case e_SIEFileCompression::GZip: sError = decompress_gzip(); break;
+            case e_SIEFileCompression::ZStd: sError = decompress_zstd(); break;
+            case e_SIEFileCompression::None: sError = "Decompression of uncompressed file requested"; break;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_sError = sError;
+            m_is_done = true;
+        }
+        m_block_available.notify_one();
+    }
+
+    std::string decompress_gzip() {
+        z_stream stream{};
+        if (inflateInit2(&stream,15 + 16) != Z_OK) return "gzip - Failed to initiate zlib";
+        c_Block input(BLOCK_SIZE);
+        c_Block output(BLOCK_SIZE);
+        std::string sError;
+        int status = Z_OK;
+        bool needs_input = true; // false = inflate filled the output and may have more pending output without more input
+        while (sError.empty()) {
+            if ((stream.avail_in == 0) && needs_input) {
+                stream.avail_in = static_cast<uInt>(read_block(input));
+                stream.next_in = reinterpret_cast<Bytef*>(input.data());
+                if (stream.avail_in == 0) {
+                    if (status != Z_STREAM_END) sError = "gzip - Unexpected end of file";
+                    break;
+                }
+            }
+            if (status == Z_STREAM_END) {
+                // Trailing zero padding after the last member is ignored (as gzip does)
+                while ((stream.avail_in > 0) && (*stream.next_in == 0)) {
+                    ++stream.next_in;
+                    --stream.avail_in;
+                }
+                if (stream.avail_in == 0) {
+                    needs_input = true;
+                    continue;
+                }
+                // More input after end of a gzip member. gzip allows concatenated members (e.g., cat a.gz b.gz)
+                inflateReset(&stream);
+                status = Z_OK;
+            }
+            stream.next_out = reinterpret_cast<Bytef*>(output.data());
+            stream.avail_out = static_cast<uInt>(output.size());
+            status = inflate(&stream,Z_NO_FLUSH);
+            if (status == Z_BUF_ERROR) {
+                // No progress possible (not fatal). inflate needs more input
+                status = Z_OK;
+                needs_input = true;
+                continue;
+            }
+            needs_input = (stream.avail_out > 0);
+            if ((status != Z_OK) && (status != Z_STREAM_END)) {
+                sError = std::string{"gzip - "} + (stream.msg ? stream.msg : "Corrupt data");
+            }
+            else if (stream.avail_out < output.size()) {
+                output.resize(output.size() - stream.avail_out);
+                if (!push_block(std::move(output))) break;
+                output = c_Block(BLOCK_SIZE);
+            }
+        }
+        inflateEnd(&stream);
+        return sError;
+    }
+
+    std::string decompress_zstd() {
+#ifdef SIE_WITH_ZSTD
+        ZSTD_DCtx* context = ZSTD_createDCtx();
+        if (context == nullptr) return "zstd - Failed to create decompression context";
+        c_Block input(BLOCK_SIZE);
+        c_Block output(BLOCK_SIZE);
+        std::string sError;
+        std::size_t status = 0;
+        ZSTD_inBuffer in_buffer{input.data(),0,0};
+        bool is_output_full = false; // zstd may have more pending output without more input
+        while (sError.empty()) {
+            if ((in_buffer.pos == in_buffer.size) && !is_output_full) {
+                in_buffer.size = read_block(input);
+                in_buffer.pos = 0;
+                if (in_buffer.size == 0) {
+                    if (status != 0) sError = "zstd - Unexpected end of file";
+                    break;
+                }
+            }
+            ZSTD_outBuffer out_buffer{output.data(),output.size(),0};
+            status = ZSTD_decompressStream(context,&out_buffer,&in_buffer);
+            // status 0 = frame decoded and fully flushed (a call without input would start a new frame)
+            is_output_full = (status != 0) && (out_buffer.pos == out_buffer.size);
+            if (ZSTD_isError(status)) {
+                sError = std::string{"zstd - "} + ZSTD_getErrorName(status);
+            }
+            else if (out_buffer.pos > 0) {
+                output.resize(out_buffer.pos);
+                if (!push_block(std::move(output))) break;
+                output = c_Block(BLOCK_SIZE);
+            }
+        }
+        ZSTD_freeDCtx(context);
+        return sError;
+#else
+        return "zstd compressed SIE file not supported (build with -DSIE_WITH_ZSTD and link with -lzstd)";
+#endif
+    }
+};
+
+class c_DecompressingIStream : public std::istream {
+public:
+    c_DecompressingIStream(std::filesystem::path const& file_path,e_SIEFileCompression compression)
+        :  std::istream(nullptr), m_stream_buf{file_path,compression} {
+        rdbuf(&m_stream_buf);
+    }
+private:
+    c_DecompressingStreamBuf m_stream_buf;
+};
+
+std::unique_ptr<std::istream> open_sie_file(std::filesystem::path const& sie_file_path) {
+    std::unique_ptr<std::istream> result;
+    auto compression = detect_compression(sie_file_path);
+    if (compression == e_SIEFileCompression::None) {
+        result = std::make_unique<std::ifstream>(sie_file_path);
+    }
+    else {
+        result = std::make_unique<c_DecompressingIStream>(sie_file_path,compression);
+    }
+    return result;
+}
+
+c_SIEFileEntries parse_sie_file(std::istream& sie_file) {
     c_SIEFileEntries sie_file_entries{};
 
     std::cout << "\nSIE Parse to BEGIN - Press any key...";
@@ -121,8 +476,9 @@ c_SIEFileEntries parse_sie_file(std::ifstream& sie_file) {
     if (sie_file) {
         unsigned int state = 0;
         bool are_sub_element_tokens = false;
-        std::string sToken{};
-        c_Tokens tokens{};
+        std::string sToken{}; // Token being built (cleared, not freed, between tokens)
+        sToken.reserve(1024);
+        c_Tokens tokens{}; // Tokens of current line (cleared, not freed, between lines)
 
         int loop_count{0}; // For Debug trace
         std::string sLine{}; // For Debug trace
@@ -194,15 +550,15 @@ c_SIEFileEntries parse_sie_file(std::ifstream& sie_file) {
                     }
                     else if (is_white_space(ch) || is_optional_new_line(ch)) {
                         // SIE file white-space == end-of-#-token
-                        tokens.push_back(sToken); // push #-token
-                        sToken = "";                        
+                        tokens.push_back(c_Token{sToken}); // push #-token
+                        sToken.clear();                        
                         state = 2; // Continue to parse tokens that are members of found #-element
                     }
                     else if (is_valid_new_line(ch)) {
                         // End-of-line == End of #-element
                         if (tokens.size() > 0) {
-                            tokens.push_back(sToken); // push #-token
-                            sToken = "";                        
+                            tokens.push_back(c_Token{sToken}); // push #-token
+                            sToken.clear();                        
                         }
                         state = 0; // Go back to next #-element (on next line)
 
@@ -216,7 +572,7 @@ c_SIEFileEntries parse_sie_file(std::ifstream& sie_file) {
                         // Error, invalid input character
                         std::cout << "\n\t" << "ERROR: Invalid #-label character ";
                         format_and_output_ch_to_cout(ch);
-                        sToken = "";
+                        sToken.clear();
                         state = 0; // Go back to next #-element (on next line)
 
                         // Trace the parsed line
@@ -236,8 +592,8 @@ c_SIEFileEntries parse_sie_file(std::ifstream& sie_file) {
                     else if (is_valid_new_line(ch)) {
                         // End of line = end of #-element
                         if (sToken.size() > 0) {
-                            tokens.push_back(sToken);
-                            sToken = "";
+                            tokens.push_back(c_Token{sToken});
+                            sToken.clear();
                         }
                         state = 0; // Go back to next #-element (on next line)
 
@@ -262,14 +618,14 @@ c_SIEFileEntries parse_sie_file(std::ifstream& sie_file) {
 
                     if (is_white_space(ch)) {
                         // SIE file white-space == end-of-#-token
-                        tokens.push_back(sToken); // push #-token
-                        sToken = "";
+                        tokens.push_back(c_Token{sToken}); // push #-token
+                        sToken.clear();
                         state = 2; // Continue to parse tokens that are members of found #-element
                     }
                     else if (is_valid_new_line(ch)) {
                         // End-of-line == End of #-element
-                        tokens.push_back(sToken);
-                        sToken = "";
+                        tokens.push_back(c_Token{sToken});
+                        sToken.clear();
                         state = 0; // Go back to next #-element (on next line)
 
                         // Trace the parsed line
@@ -292,8 +648,8 @@ c_SIEFileEntries parse_sie_file(std::ifstream& sie_file) {
 
                     if (ch == '"') {
                         // End of "..." enclosed value token
-                        tokens.push_back(sToken); // Push back even empty token enclosed in "..."
-                        sToken = "";
+                        tokens.push_back(c_Token{sToken,e_TokenKind::Quoted}); // Push back even empty token enclosed in "..."
+                        sToken.clear();
                         state = 2; // Continue to parse tokens that are members of found #-element
                     }
                     else {
@@ -347,7 +703,345 @@ c_OptionalSIEFileAmount get_IB_Amount(const c_SIEFileEntries& sie_file_entries,i
         }
     );
     if (iter != sie_file_entries.end()) {
-        result = {iter->tokens()[3]};
+        result = {iter->tokens()[3].str()};
+    }
+    return result;
+}
+
+/**
+ * SIE dates are YYYYMMDD tokens. We pack them to a day number (days since 1970-01-01)
+ * so that they can be ordered and compared as plain integers.
+ * See http://howardhinnant.github.io/date_algorithms.html (days_from_civil)
+ * */
+using c_DayNumber = int;
+using c_OptionalDayNumber = std::optional<c_DayNumber>;
+
+c_DayNumber to_day_number(int year, int month, int day) {
+    year -= (month <= 2) ? 1 : 0;
+    const int era = ((year >= 0) ? year : year - 399) / 400;
+    const int year_of_era = year - era * 400;
+    const int day_of_year = (153 * (month + ((month > 2) ? -3 : 9)) + 2) / 5 + day - 1;
+    const int day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+struct c_Date {
+    int m_year;
+    int m_month; // 1..12
+    int m_day;   // 1..31
+};
+
+c_Date to_date(c_DayNumber day_number) {
+    // See http://howardhinnant.github.io/date_algorithms.html (civil_from_days)
+    day_number += 719468;
+    const int era = ((day_number >= 0) ? day_number : day_number - 146096) / 146097;
+    const int day_of_era = day_number - era * 146097;
+    const int year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const int day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const int shifted_month = (5 * day_of_year + 2) / 153; // March = 0
+    const int day = day_of_year - (153 * shifted_month + 2) / 5 + 1;
+    const int month = shifted_month + ((shifted_month < 10) ? 3 : -9);
+    return {year_of_era + era * 400 + ((month <= 2) ? 1 : 0),month,day};
+}
+
+int days_in_month(int year,int month) {
+    static constexpr int DAYS_IN_MONTH[12] = {31,28,31,30,31,30,31,31,30,31,30,31};
+    const bool is_leap_year = ((year % 4 == 0) && (year % 100 != 0)) || (year % 400 == 0);
+    return ((month == 2) && is_leap_year) ? 29 : DAYS_IN_MONTH[month - 1];
+}
+
+c_OptionalDayNumber to_day_number(std::string_view sYYYYMMDD) {
+    c_OptionalDayNumber result;
+    if (    (sYYYYMMDD.size() == 8)
+         && std::all_of(sYYYYMMDD.begin(),sYYYYMMDD.end(),[](char ch) {return (ch >= '0') && (ch <= '9');})) {
+        auto to_int = [&sYYYYMMDD](std::size_t pos,std::size_t count) {
+            int result = 0;
+            for (auto ch : sYYYYMMDD.substr(pos,count)) result = result * 10 + (ch - '0');
+            return result;
+        };
+        const int year = to_int(0,4);
+        const int month = to_int(4,2);
+        const int day = to_int(6,2);
+        if ((month >= 1) && (month <= 12) && (day >= 1) && (day <= days_in_month(year,month))) {
+            result = to_day_number(year,month,day);
+        }
+    }
+    return result;
+}
+
+/**
+ * SIE amounts are decimal tokens with at most two decimals (e.g. "-63000.00").
+ * We accumulate them as integer cents ("öre") to keep period sums exact.
+ * */
+using c_Cents = long long;
+using c_OptionalCents = std::optional<c_Cents>;
+
+c_OptionalCents to_cents(std::string_view sAmount) {
+    c_OptionalCents result;
+    c_Cents units = 0;
+    c_Cents cents = 0;
+    int decimals = -1; // -1 = no decimal point seen
+    bool has_digits = false;
+    auto iter = sAmount.begin();
+    const bool is_negative = (iter != sAmount.end()) && (*iter == '-');
+    if (is_negative) ++iter;
+    for (;iter != sAmount.end();++iter) {
+        if ((*iter >= '0') && (*iter <= '9')) {
+            has_digits = true;
+            if (decimals < 0) {
+                units = units * 10 + (*iter - '0');
+            }
+            else if (decimals < 2) {
+                cents = cents * 10 + (*iter - '0');
+                ++decimals;
+            }
+            else {
+                return result; // More than two decimals is not a valid SIE amount
+            }
+        }
+        else if ((*iter == '.') && (decimals < 0)) {
+            decimals = 0;
+        }
+        else {
+            return result; // Invalid amount character
+        }
+    }
+    if (has_digits) {
+        if (decimals == 1) cents *= 10; // "12.5" == 12.50
+        const c_Cents amount = units * 100 + cents;
+        result = is_negative ? -amount : amount;
+    }
+    return result;
+}
+
+std::string to_sie_amount(c_Cents amount) {
+    const c_Cents abs_amount = (amount < 0) ? -amount : amount;
+    std::string sCents = std::to_string(abs_amount % 100);
+    if (sCents.size() < 2) sCents.insert(0,"0");
+    return ((amount < 0) ? "-" : "") + std::to_string(abs_amount / 100) + "." + sCents;
+}
+
+/**
+ * Period index over #VER/#TRANS entries of parsed SIE file entries.
+ * Vouchers are sorted by day number and each account keeps its postings sorted by day
+ * with running (prefix) sums. Thus the movement of an account over any period
+ * (day, month, quarter, year) is two binary searches and a subtraction, and we do not
+ * need to re-scan all #TRANS entries for each period of a report.
+ * */
+class c_SIEPeriodIndex {
+public:
+    c_SIEPeriodIndex(c_SIEFileEntries const& sie_file_entries);
+
+    // Indexes into the indexed SIE file entries of #VER entries dated within [first_day,last_day]
+    std::vector<std::size_t> vouchers(c_DayNumber first_day,c_DayNumber last_day) const;
+
+    // Sum of #TRANS amounts for account dated within [first_day,last_day]
+    c_Cents movement(std::string const& account_number,c_DayNumber first_day,c_DayNumber last_day) const;
+
+    // Sum of movement over all accounts in [first_account_number,last_account_number] (e.g. "3000".."3999" for revenue)
+    c_Cents movement(std::string const& first_account_number,std::string const& last_account_number,c_DayNumber first_day,c_DayNumber last_day) const;
+
+    // #IB of the #RAR fiscal year that contains day plus movement from the start of that year up to and including day.
+    // #UB if day is the last day of a fiscal year. None if the fiscal year has no vouchers in the file
+    // (a SIE 4 file normally carries #VER entries for the current year only).
+    c_OptionalSIEFileAmount balance(std::string const& account_number,c_DayNumber day) const;
+
+    struct c_FiscalYear {
+        int m_year_index; // 0 = current year, -1 = previous year, ...
+        c_DayNumber m_first_day;
+        c_DayNumber m_last_day;
+        bool m_has_vouchers; // #VER entries dated within the year exist in the file
+    };
+
+    // The #RAR fiscal year with provided year index (if any)
+    std::optional<c_FiscalYear> fiscal_year(int year_index) const;
+
+private:
+    struct c_Voucher {
+        c_DayNumber m_day;
+        std::size_t m_entry_index;
+    };
+
+    struct c_Posting {
+        c_DayNumber m_day;
+        c_Cents m_amount;
+    };
+
+    struct c_AccountPostings {
+        std::vector<c_Posting> m_postings; // sorted on day
+        std::vector<c_Cents> m_prefix_sums; // m_prefix_sums[i] = sum of m_postings[0..i)
+    };
+
+    std::vector<c_Voucher> m_vouchers; // sorted on day
+    std::map<std::string,c_AccountPostings> m_account_postings;
+    std::vector<c_FiscalYear> m_fiscal_years;
+    std::map<std::pair<int,std::string>,c_Cents> m_ib_amounts; // (year index,account) -> #IB
+    std::map<std::pair<int,std::string>,c_Cents> m_ub_amounts; // (year index,account) -> #UB
+
+    static c_Cents movement(c_AccountPostings const& account_postings,c_DayNumber first_day,c_DayNumber last_day);
+};
+
+std::optional<int> to_year_index(std::string_view sYearIndex) {
+    std::optional<int> result;
+    int year_index = 0;
+    auto [ptr,error] = std::from_chars(sYearIndex.data(),sYearIndex.data() + sYearIndex.size(),year_index);
+    if ((error == std::errc{}) && (ptr == sYearIndex.data() + sYearIndex.size())) {
+        result = year_index;
+    }
+    return result;
+}
+
+c_SIEPeriodIndex::c_SIEPeriodIndex(c_SIEFileEntries const& sie_file_entries) {
+    for (std::size_t entry_index = 0; entry_index < sie_file_entries.size(); ++entry_index) {
+        auto const& entry = sie_file_entries[entry_index];
+        auto const& tokens = entry.tokens();
+        if ((tokens.size() >= 4) && (tokens[0] == "#RAR")) {
+            // #RAR årsnr start slut
+            auto year_index = to_year_index(tokens[1].view());
+            auto first_day = to_day_number(tokens[2].view());
+            auto last_day = to_day_number(tokens[3].view());
+            if (!year_index) {
+                std::cout << "\nERROR: Period index - Invalid #RAR year index " << tokens[1];
+            }
+            else if (!first_day || !last_day) {
+                std::cout << "\nERROR: Period index - Invalid #RAR date " << tokens[2] << " " << tokens[3];
+            }
+            else {
+                m_fiscal_years.push_back({*year_index,*first_day,*last_day,false});
+            }
+        }
+        else if ((tokens.size() >= 4) && ((tokens[0] == "#IB") || (tokens[0] == "#UB"))) {
+            // #IB årsnr konto saldo kvantitet
+            // #UB årsnr konto saldo kvantitet
+            auto year_index = to_year_index(tokens[1].view());
+            auto amount = to_cents(tokens[3].view());
+            if (!year_index) {
+                std::cout << "\nERROR: Period index - Invalid " << tokens[0] << " year index " << tokens[1];
+            }
+            else if (!amount) {
+                std::cout << "\nERROR: Period index - Invalid " << tokens[0] << " amount " << tokens[3];
+            }
+            else {
+                auto& amounts = (tokens[0] == "#IB") ? m_ib_amounts : m_ub_amounts;
+                amounts[{*year_index,tokens[2].str()}] = *amount;
+            }
+        }
+        else if ((tokens.size() >= 4) && (tokens[0] == "#VER")) {
+            // #VER serie vernr verdatum vertext regdatum sign
+            auto voucher_day = to_day_number(tokens[3].view());
+            if (!voucher_day) {
+                std::cout << "\nERROR: Period index - Invalid #VER date " << tokens[3];
+                continue;
+            }
+            m_vouchers.push_back({*voucher_day,entry_index});
+            for (auto const& sub_entry : entry.sub_entries()) {
+                // #TRANS kontonr {objektlista} belopp transdat transtext kvantitet sign
+                if ((sub_entry.size() < 4) || (sub_entry[0] != "#TRANS")) continue;
+                // Skip the object list. It may have been tokenised into several tokens "{1", "100}"
+                std::size_t amount_index = 2;
+                while ((amount_index < sub_entry.size()) && (sub_entry[amount_index].empty() || (sub_entry[amount_index].back() != '}'))) ++amount_index;
+                ++amount_index;
+                if (amount_index >= sub_entry.size()) continue;
+                auto amount = to_cents(sub_entry[amount_index].view());
+                if (!amount) {
+                    std::cout << "\nERROR: Period index - Invalid #TRANS amount " << sub_entry[amount_index];
+                    continue;
+                }
+                // The transaction date is optional and defaults to the voucher date
+                c_OptionalDayNumber trans_day;
+                if (amount_index + 1 < sub_entry.size()) trans_day = to_day_number(sub_entry[amount_index + 1].view());
+                m_account_postings[sub_entry[1].str()].m_postings.push_back({trans_day.value_or(*voucher_day),*amount});
+            }
+        }
+    }
+
+    std::stable_sort(m_vouchers.begin(),m_vouchers.end(),[](c_Voucher const& v1,c_Voucher const& v2) {
+        return v1.m_day < v2.m_day;
+    });
+    for (auto& fiscal_year : m_fiscal_years) {
+        fiscal_year.m_has_vouchers = !vouchers(fiscal_year.m_first_day,fiscal_year.m_last_day).empty();
+    }
+    for (auto& [account_number,account_postings] : m_account_postings) {
+        auto& postings = account_postings.m_postings;
+        std::stable_sort(postings.begin(),postings.end(),[](c_Posting const& p1,c_Posting const& p2) {
+            return p1.m_day < p2.m_day;
+        });
+        account_postings.m_prefix_sums.reserve(postings.size() + 1);
+        account_postings.m_prefix_sums.push_back(0);
+        for (auto const& posting : postings) {
+            account_postings.m_prefix_sums.push_back(account_postings.m_prefix_sums.back() + posting.m_amount);
+        }
+    }
+}
+
+std::vector<std::size_t> c_SIEPeriodIndex::vouchers(c_DayNumber first_day,c_DayNumber last_day) const {
+    std::vector<std::size_t> result;
+    auto begin = std::lower_bound(m_vouchers.begin(),m_vouchers.end(),first_day,[](c_Voucher const& voucher,c_DayNumber day) {
+        return voucher.m_day < day;
+    });
+    auto end = std::upper_bound(begin,m_vouchers.end(),last_day,[](c_DayNumber day,c_Voucher const& voucher) {
+        return day < voucher.m_day;
+    });
+    std::transform(begin,end,std::back_inserter(result),[](c_Voucher const& voucher) {return voucher.m_entry_index;});
+    return result;
+}
+
+c_Cents c_SIEPeriodIndex::movement(c_AccountPostings const& account_postings,c_DayNumber first_day,c_DayNumber last_day) {
+    auto const& postings = account_postings.m_postings;
+    auto begin = std::lower_bound(postings.begin(),postings.end(),first_day,[](c_Posting const& posting,c_DayNumber day) {
+        return posting.m_day < day;
+    });
+    auto end = std::upper_bound(begin,postings.end(),last_day,[](c_DayNumber day,c_Posting const& posting) {
+        return day < posting.m_day;
+    });
+    return account_postings.m_prefix_sums[end - postings.begin()] - account_postings.m_prefix_sums[begin - postings.begin()];
+}
+
+c_Cents c_SIEPeriodIndex::movement(std::string const& account_number,c_DayNumber first_day,c_DayNumber last_day) const {
+    auto iter = m_account_postings.find(account_number);
+    return (iter != m_account_postings.end()) ? movement(iter->second,first_day,last_day) : 0;
+}
+
+c_Cents c_SIEPeriodIndex::movement(std::string const& first_account_number,std::string const& last_account_number,c_DayNumber first_day,c_DayNumber last_day) const {
+    // NOTE: Account numbers are compared as strings. This is numeric order as long as they have the same number of digits (BAS accounts are 4 digits)
+    c_Cents result = 0;
+    auto end = m_account_postings.upper_bound(last_account_number);
+    for (auto iter = m_account_postings.lower_bound(first_account_number); iter != end; ++iter) {
+        result += movement(iter->second,first_day,last_day);
+    }
+    return result;
+}
+
+c_OptionalSIEFileAmount c_SIEPeriodIndex::balance(std::string const& account_number,c_DayNumber day) const {
+    c_OptionalSIEFileAmount result;
+    auto fiscal_year = std::find_if(m_fiscal_years.begin(),m_fiscal_years.end(),[day](c_FiscalYear const& fiscal_year) {
+        return (fiscal_year.m_first_day <= day) && (day <= fiscal_year.m_last_day);
+    });
+    if (fiscal_year == m_fiscal_years.end()) {
+        return result;
+    }
+    auto ub_amount = m_ub_amounts.find({fiscal_year->m_year_index,account_number});
+    if ((day == fiscal_year->m_last_day) && (ub_amount != m_ub_amounts.end())) {
+        result = {to_sie_amount(ub_amount->second)};
+    }
+    else if (fiscal_year->m_has_vouchers) {
+        c_Cents amount = movement(account_number,fiscal_year->m_first_day,day);
+        auto ib_amount = m_ib_amounts.find({fiscal_year->m_year_index,account_number});
+        if (ib_amount != m_ib_amounts.end()) {
+            amount += ib_amount->second;
+        }
+        result = {to_sie_amount(amount)};
+    }
+    return result;
+}
+
+std::optional<c_SIEPeriodIndex::c_FiscalYear> c_SIEPeriodIndex::fiscal_year(int year_index) const {
+    std::optional<c_FiscalYear> result;
+    auto iter = std::find_if(m_fiscal_years.begin(),m_fiscal_years.end(),[year_index](c_FiscalYear const& fiscal_year) {
+        return fiscal_year.m_year_index == year_index;
+    });
+    if (iter != m_fiscal_years.end()) {
+        result = *iter;
     }
     return result;
 }
@@ -659,10 +1353,10 @@ int main(int argc, const char * argv[]) {
     // Choose and open SIE file
     std::string sSIEFileName = (argc > 1) ? argv[1] : "../sie/2326 ITFied 1505-1604.se";
     std::filesystem::path sie_file_path(sSIEFileName);
-    std::ifstream sie_file(sie_file_path);
+    auto sie_file = open_sie_file(sie_file_path); // Plain or gzip/zstd compressed
 
     // User feed back
-    if (sie_file) {
+    if (*sie_file) {
         std::cout << "\nWill Open File " << sie_file_path;
     }
     else {
@@ -673,7 +1367,13 @@ int main(int argc, const char * argv[]) {
     std::cin.get(dummy_char);
 
     // Parse the SIE file
-    c_SIEFileEntries sie_file_entries = parse_sie_file(sie_file);
+    c_SIEFileEntries sie_file_entries = parse_sie_file(*sie_file);
+    if (sie_file->bad()) {
+        // Do not report on partially parsed entries (e.g., truncated or corrupt compressed archive)
+        std::cout << "\nERROR: Failed to read SIE file " << sie_file_path << " - Aborted";
+        std::cout << '\n';
+        return 1;
+    }
 
     // Dump parsed entries
     const int no_entries_per_page = 40;
@@ -688,6 +1388,30 @@ int main(int argc, const char * argv[]) {
         std::cout << entry;
     }
 
+    // Index vouchers on date for period queries
+    c_SIEPeriodIndex period_index(sie_file_entries);
+
+    // Dump number of vouchers and revenue (BAS accounts 3000..3999) per month of current fiscal year (#RAR 0)
+    std::cout << "\nPeriod Index - BEGIN";
+    if (auto fiscal_year = period_index.fiscal_year(0)) {
+        c_Date month_start = to_date(fiscal_year->m_first_day);
+        month_start.m_day = 1;
+        for (c_DayNumber first_day = fiscal_year->m_first_day; first_day <= fiscal_year->m_last_day;) {
+            const c_DayNumber last_day = std::min(
+                 to_day_number(month_start.m_year,month_start.m_month,days_in_month(month_start.m_year,month_start.m_month))
+                ,fiscal_year->m_last_day);
+            std::cout << "\n" << month_start.m_year << ((month_start.m_month < 10) ? "-0" : "-") << month_start.m_month
+                      << "\tvouchers " << period_index.vouchers(first_day,last_day).size()
+                      << "\trevenue " << to_sie_amount(period_index.movement("3000","3999",first_day,last_day));
+            first_day = last_day + 1;
+            month_start = to_date(first_day);
+        }
+    }
+    else {
+        std::cout << "\nNo current fiscal year (#RAR 0)";
+    }
+    std::cout << "\nPeriod Index - END";
+
     c_AnnualReport annual_report = create_annual_report(sie_file_entries);
 
     // Dump the annual report